@@ -8,9 +8,21 @@
 *
 * Version:
 * 1.01	/ 13.01.2020
+* 1.02	/ 18.10.2026 Table-driven CRC32 (selectable Engine), Option '--bench'
+* 1.03	/ 18.10.2026 Bundle Header Type 1 (several Components in one File), '-k'
+* 1.04	/ 18.10.2026 Option '--mapsize' (Flash/RAM per Module from Linker Map)
+* 1.05	/ 18.10.2026 '--bench' extended: Synthetic HEX, all Stages, JSON Output
+* 1.06	/ 18.10.2026 Option '--stats' (Timing per Phase, Counters)
+* 1.07	/ 18.10.2026 Option '--verify' (Check Header Type 0/1 Files, parallel)
+* 1.08	/ 18.10.2026 Option '--lint' (only check HEX Files, no Output)
+* 1.09	/ 18.10.2026 Several Outputs '-o' (each with own '-c'/'-h') in one Run
+* 1.10	/ 18.10.2026 UICR accepted, '-l' (SES Layout) and '--split' per Region
+* 1.11	/ 18.10.2026 Chunk Store: '--store' (Content-Defined Chunks), '--unpack'
+* 1.12	/ 18.10.2026 Packetizer '--packets' (Blocks for BLE-MTU) and '--resume'
+* 1.13	/ 18.10.2026 Option '--usage' (Used/Unused/Overwritten Ranges, opt. JSON)
 *********************************************************************************/
 
-#define VERSION "1.01 / 13.01.2020"
+#define VERSION "1.13 / 18.10.2026"
 
 #define _CRT_SECURE_NO_WARNINGS // For VisualStudio
 #include <stdio.h>
@@ -19,6 +31,16 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <time.h>
+#include <ctype.h>
+#ifndef _WIN32
+#include <sys/resource.h>	// getrusage() for '--stats'
+#include <sys/mman.h>	// mmap() for '--verify'
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <direct.h>	// _mkdir() for '--store'
+#endif
 
 #define MAX_BUF	2048*1024	// 2MB fix
 
@@ -29,15 +51,48 @@ int		min_bin_addr = MAX_BUF-1;	// Used Addresses
 int		max_bin_addr = 0;
 int		bin_bytes_cnt;
 
+// UICR is outside 'binbuf', kept separately (only written with '--split')
+#define UICR_START	0x10001000
+#define UICR_SIZE	0x1000
+uint8_t uicrbuf[UICR_SIZE];	// init with BINDEF_VAL
+uint8_t uicrused[UICR_SIZE];
+int		uicr_bytes_cnt;
+
 #define MAXLINE	120
 char in_line[MAXLINE + 1];
 int in_line_cnt, total_line_cnt;
 
 #define MAX_WARN	10		// Maximum displayed Warnings
 int warnings_cnt;
+int verbose = 1;	// 0: No Info/Warnings (for '--bench')
 
 int lowest_output_addr = -1;
 
+// Outputs ('-o'), each with the '-c'/'-h' Settings given before it
+#define MAX_OUT	16
+typedef struct {
+	char* name;
+	int low_addr;	// -1: Lowest used Addr.
+	int hdrtype;	// -1: No Header
+	uint32_t par1;
+} OUT_SPEC;
+OUT_SPEC out_tab[MAX_OUT];
+int out_cnt;
+
+// Statistics ('--stats'): Time and Bytes per Phase, Record Counts
+int stats;
+enum { ST_IO, ST_DECODE, ST_MERGE, ST_CRC, ST_HEADER, ST_OUTPUT, ST_CNT };
+double st_secs[ST_CNT];
+double st_bytes[ST_CNT];
+int rec_type_cnt[6];
+
+/* Wall Time in Seconds (C11), for Statistics and Benchmarks */
+double get_secs(void) {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
 static char* pbyte;
 static uint8_t fcs;
 int getbyte(void){
@@ -64,16 +119,110 @@ int getuint16(void) {
 	return (ret16h << 8) + ret16l;
 }
 
+// Lint ('--lint'): Only check Input, 'binbuf'/'usedbuf' are never touched.
+// Used Addresses are kept as Extents (contiguous Ranges) to find Overlaps
+int lint;
+int lint_nonmono_cnt;
+typedef struct {
+	uint32_t start;
+	uint32_t end;	// Exclusive
+	int file_idx;
+} EXTENT;
+EXTENT* ext_tab;
+int ext_cnt, ext_max;
+EXTENT ext_cur;	// Extent in Progress (end == start: none)
+char* lint_fnames[256];
+int lint_file_cnt;
+
+// Valid Areas of the nRF52840 (see flash_placement.xml): FLASH_PH (from 0) and UICR
+#define NRF_FLASH_END	0x00100000
+#define NRF_UICR_START	0x10001000
+#define NRF_UICR_END	0x10002000
+
+/* Check new Range (start...end-1) against all closed Extents */
+int lint_check_overlap(uint32_t start, uint32_t end) {
+	int i;
+	EXTENT* pe;
+	for (i = 0; i < ext_cnt; i++) {
+		pe = &ext_tab[i];
+		if (start < pe->end && pe->start < end) {
+			printf("ERROR: Overlap at Addr: 0x%X...0x%X ('%s' and '%s') in Line %d\n",
+				start > pe->start ? start : pe->start, (end < pe->end ? end : pe->end) - 1,
+				lint_fnames[pe->file_idx], lint_fnames[lint_file_cnt - 1], in_line_cnt);
+			return -31;
+		}
+	}
+	return 0;
+}
+
+/* Close Extent in Progress (already checked Record by Record) */
+int lint_close_extent(void) {
+	EXTENT* pe;
+	if (ext_cur.end == ext_cur.start) return 0;
+	if (ext_cnt == ext_max) {
+		ext_max = ext_max ? ext_max * 2 : 64;
+		pe = realloc(ext_tab, ext_max * sizeof(EXTENT));
+		if (!pe) {
+			printf("ERROR: Out of Memory\n");
+			return -30;
+		}
+		ext_tab = pe;
+	}
+	ext_tab[ext_cnt++] = ext_cur;
+	ext_cur.end = ext_cur.start;
+	return 0;
+}
+
+/* Check one Data Record (Map, Monotonicity, Overlap) */
+int lint_record(uint32_t addr, int len) {
+	uint32_t end;
+	int res;
+	if (!len) return 0;
+	// Written without Overflow ('addr + len' may wrap)
+	if (!(addr <= NRF_FLASH_END - (uint32_t)len || (addr >= NRF_UICR_START && addr <= NRF_UICR_END - (uint32_t)len))) {
+		printf("ERROR: Addr: 0x%X (+%d) outside nRF52840 Flash/UICR in Line %d\n", addr, len, in_line_cnt);
+		return -32;
+	}
+	end = addr + len;
+	res = lint_check_overlap(addr, end);	// Stop as early as possible
+	if (res) return res;
+	if (ext_cur.end != ext_cur.start && addr == ext_cur.end) {	// Contiguous: extend
+		ext_cur.end = end;
+		return 0;
+	}
+	if (ext_cur.end != ext_cur.start && addr < ext_cur.end) {
+		if (end > ext_cur.start) {
+			printf("ERROR: Overlap at Addr: 0x%X in Line %d\n", addr, in_line_cnt);
+			return -31;
+		}
+		if (lint_nonmono_cnt++ < MAX_WARN) {
+			printf("WARNING: Address not increasing (0x%X) in Line %d\n", addr, in_line_cnt);
+		}
+	}
+	res = lint_close_extent();
+	if (res) return res;
+	ext_cur.start = addr;
+	ext_cur.end = end;
+	ext_cur.file_idx = lint_file_cnt - 1;
+	return 0;
+}
+
 /* Write 1 Byte to Buffer */
 int write_byte(int addr, int val) {
 	uint8_t ubc;	// Used Buffer Counter, should be 0
+	if (addr >= UICR_START && addr < UICR_START + UICR_SIZE) {
+		if (uicrused[addr - UICR_START] < 255) uicrused[addr - UICR_START]++;
+		uicrbuf[addr - UICR_START] = val;
+		uicr_bytes_cnt++;
+		return 0;
+	}
 	if (addr < 0 || addr >= MAX_BUF) {
 		return -1;
 	}
 	ubc = usedbuf[addr];
 	if (ubc) {
-		if (warnings_cnt++ < MAX_WARN) {
-			printf("WARNING: Overwriting Memory at Addr: 0x%X",addr);
+		if (warnings_cnt++ < MAX_WARN && verbose) {
+			printf("WARNING: Overwriting Memory at Addr: 0x%X\n",addr);
 		}
 	}
 	if (ubc < 255) usedbuf[addr] = ubc + 1; // Mark usage / color array
@@ -93,18 +242,36 @@ int read_infile(char* infilename) {
 	int badr = 0; // 16 Bit Address (before data)
 	int boffset = 0; // 32 Bit Offset for following data
 	int init_seg, init_lu16, init_hu16;
+	int i;
+	uint8_t rec[256];	// Data of one Record
+	double t0 = 0, t1;
+	if (stats) t0 = get_secs();
 	inf = fopen(infilename, "r");
 	if (!inf) {
 		printf("ERROR: Can't open '%s'\n", infilename);
 		return -1;
 	}
-	printf("Input File '%s'\n", infilename);
+	if (verbose) printf("Input File '%s'\n", infilename);
 	in_line_cnt = 0;
+	if (lint) {
+		if (lint_file_cnt >= (int)(sizeof(lint_fnames) / sizeof(lint_fnames[0]))) {
+			printf("ERROR: Too many Files\n");
+			return -30;
+		}
+		lint_fnames[lint_file_cnt++] = infilename;
+		ext_cur.end = ext_cur.start;	// Extents never span Files
+	}
 	for (;;) {
 		if (!fgets(in_line, MAXLINE, inf)) {
 			printf("ERROR: Unexpected File End in Line %d\n", in_line_cnt);
 			return -2;
 		}
+		if (stats) {
+			t1 = get_secs();
+			st_secs[ST_IO] += t1 - t0;
+			st_bytes[ST_IO] += strlen(in_line);
+			t0 = t1;
+		}
 		pc = in_line;
 		if (*pc++ != ':') {
 			printf("ERROR: Missing ':' in Line %d\n", in_line_cnt);
@@ -124,20 +291,44 @@ int read_infile(char* infilename) {
 		}
 
 		rtyp = getbyte();
+		if (rtyp >= 0 && rtyp < 6) rec_type_cnt[rtyp]++;
 		switch (rtyp) {
-		case 0:	// Data Record
-			while (rlen--) {
+		case 0:	// Data Record: Decode and check, then merge
+			for (i = 0; i < rlen; i++) {
 				bval = getbyte();
-				if (write_byte(badr+boffset, bval)) {
+				if (bval < 0) {
+					printf("ERROR: Typ:%02X - Illegal Character in Line %d\n", rtyp, in_line_cnt);
+					return -7;
+				}
+				rec[i] = (uint8_t)bval;
+			}
+			if (getbyte() < 0 || fcs) {
+				printf("ERROR: Typ:%02X - FCS Error in Line %d\n", rtyp, in_line_cnt);
+				return -6;
+			}
+			if (stats) {
+				t1 = get_secs();
+				st_secs[ST_DECODE] += t1 - t0;
+				st_bytes[ST_DECODE] += rlen;
+				t0 = t1;
+			}
+			if (lint) {
+				bval = lint_record(badr + boffset, rlen);
+				if (bval) return bval;
+				bin_bytes_cnt += rlen;
+				break;
+			}
+			for (i = 0; i < rlen; i++) {
+				if (write_byte(badr+boffset, rec[i])) {
 					printf("ERROR: Typ:%02X - Illegal Write(Addr: 0x%X) in Line %d\n", rtyp, badr, in_line_cnt);
 					return -5;
 				}
 				badr++;
 			}
-			getbyte();
-			if (fcs) {
-				printf("ERROR: Typ:%02X - FCS Error in Line %d\n", rtyp, in_line_cnt);
-				return -6;
+			if (stats) {
+				t1 = get_secs();
+				st_secs[ST_MERGE] += t1 - t0;
+				st_bytes[ST_MERGE] += rlen;
 			}
 			break;
 		case 1: // End
@@ -146,6 +337,7 @@ int read_infile(char* infilename) {
 				return -4;
 			}
 			fclose(inf);
+			if (lint) return lint_close_extent();
 			return 0;	// Regular Return, NO ERROR
 
 		case 2:	// extended segment address record (added as '<<4') in Segment-Form
@@ -199,11 +391,27 @@ int read_infile(char* infilename) {
 
 		in_line_cnt++;
 		total_line_cnt++;
+		if (stats) t0 = get_secs();
 	}
 }
-/* Same as JesFs CRC32: Calculating a CRC32: Also useful for external use */
+/* Same as JesFs CRC32: Calculating a CRC32: Also useful for external use
+* Three compatible Engines (identical Results), selected at Compile Time:
+* CRC32_ENGINE 0: Bitwise, no Table (smallest, ca. 8 Loops per Byte)
+* CRC32_ENGINE 1: Nibble-Table, 16 Entries (64 Bytes)
+* CRC32_ENGINE 2: Byte-Table, 256 Entries (1 kB, fastest)
+* CRC32_TABLE_RAM 0: Tables are 'const' (Flash on Target), 1: Tables are built
+* at Runtime by crc32_init() (RAM on Target, no Flash for the Table)
+* All Engines are always compiled here (for '--bench'), the Bootloader only
+* needs the selected one. */
+#ifndef CRC32_ENGINE
+#define CRC32_ENGINE	2
+#endif
+#ifndef CRC32_TABLE_RAM
+#define CRC32_TABLE_RAM	0
+#endif
+
 #define POLY32 0xEDB88320 // ISO 3309
-uint32_t fs_track_crc32(uint8_t* pdata, uint32_t wlen, uint32_t crc_run) {
+uint32_t crc32_bitwise(uint8_t* pdata, uint32_t wlen, uint32_t crc_run) {
 	uint8_t j;
 	while (wlen--) {
 		crc_run ^= *pdata++;
@@ -217,6 +425,132 @@ uint32_t fs_track_crc32(uint8_t* pdata, uint32_t wlen, uint32_t crc_run) {
 	return crc_run;
 }
 
+#if CRC32_TABLE_RAM
+static uint32_t crc32_tab_nibble[16];
+static uint32_t crc32_tab_byte[256];
+#else
+static const uint32_t crc32_tab_nibble[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+static const uint32_t crc32_tab_byte[256] = {
+	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+	0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+	0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+	0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+	0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+	0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+	0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+	0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+	0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+	0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+	0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+	0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+	0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+	0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+	0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+	0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+	0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+	0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+	0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+	0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+	0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+	0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+	0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+	0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+	0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+	0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+	0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+	0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+	0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+#endif
+
+/* Build the Tables (only required for CRC32_TABLE_RAM) */
+void crc32_init(void) {
+#if CRC32_TABLE_RAM
+	uint32_t i;
+	uint8_t b;
+	for (i = 0; i < 256; i++) {
+		b = (uint8_t)i;
+		crc32_tab_byte[i] = crc32_bitwise(&b, 1, 0);
+	}
+	for (i = 0; i < 16; i++) crc32_tab_nibble[i] = crc32_tab_byte[i << 4];	// Same as 4 Bit-Steps on i
+#endif
+}
+
+uint32_t crc32_nibble(uint8_t* pdata, uint32_t wlen, uint32_t crc_run) {
+	while (wlen--) {
+		crc_run ^= *pdata++;
+		crc_run = (crc_run >> 4) ^ crc32_tab_nibble[crc_run & 15];
+		crc_run = (crc_run >> 4) ^ crc32_tab_nibble[crc_run & 15];
+	}
+	return crc_run;
+}
+
+uint32_t crc32_byte(uint8_t* pdata, uint32_t wlen, uint32_t crc_run) {
+	while (wlen--) {
+		crc_run = (crc_run >> 8) ^ crc32_tab_byte[(crc_run ^ *pdata++) & 255];
+	}
+	return crc_run;
+}
+
+uint32_t fs_track_crc32(uint8_t* pdata, uint32_t wlen, uint32_t crc_run) {
+#if CRC32_ENGINE == 0
+	return crc32_bitwise(pdata, wlen, crc_run);
+#elif CRC32_ENGINE == 1
+	return crc32_nibble(pdata, wlen, crc_run);
+#else
+	return crc32_byte(pdata, wlen, crc_run);
+#endif
+}
+
+/* Print one Benchmark Result, opt. also as JSON Object to jsonf */
+int bench_json_cnt;
+void bench_result(FILE* jsonf, const char* name, double bytes, double secs) {
+	double mbs = (secs > 0) ? bytes / secs / 1e6 : 0;
+	printf("  %-32s %10.0f Bytes %9.3f msec %8.1f MB/s\n", name, bytes, secs * 1000.0, mbs);
+	if (jsonf) {
+		fprintf(jsonf, "%s\n    {\"name\": \"%s\", \"bytes\": %.0f, \"secs\": %.6f, \"mb_per_s\": %.2f}",
+			bench_json_cnt++ ? "," : "", name, bytes, secs, mbs);
+	}
+}
+
+/* Compare all CRC32 Engines on 'binbuf' (also Self-Test). Timing is Wall Time,
+* on Target use DWT->CYCCNT instead to get Cycles per Byte */
+#define BENCH_CRC_SIZE	(1024*1024)	// 1 MB, like a full App
+int bench_crc32(FILE* jsonf) {
+	static const char* names[3] = { "crc32_bitwise", "crc32_nibble", "crc32_byte" };
+	uint32_t(*engines[3])(uint8_t*, uint32_t, uint32_t) = { crc32_bitwise, crc32_nibble, crc32_byte };
+	uint32_t crc, crc_ref = 0, seed = 12345;
+	double t0;
+	int i;
+
+	if (fs_track_crc32((uint8_t*)"123456789", 9, 0xFFFFFFFF) != ~0xCBF43926) {	// ISO 3309 Check Value
+		printf("ERROR: CRC32 Self-Test failed\n");
+		return -22;
+	}
+	for (i = 0; i < BENCH_CRC_SIZE; i++) {	// Pseudo Random Data
+		seed = seed * 1103515245 + 12345;
+		binbuf[i] = (uint8_t)(seed >> 16);
+	}
+	printf("CRC32 Engine: %d (Table in %s), %d Bytes:\n", CRC32_ENGINE, CRC32_TABLE_RAM ? "RAM" : "Flash", BENCH_CRC_SIZE);
+	for (i = 0; i < 3; i++) {
+		t0 = get_secs();
+		crc = engines[i](binbuf, BENCH_CRC_SIZE, 0xFFFFFFFF);
+		bench_result(jsonf, names[i], BENCH_CRC_SIZE, get_secs() - t0);
+		if (!i) crc_ref = crc;
+		if (crc != crc_ref) {
+			printf("ERROR: CRC32 Engines differ\n");
+			return -22;
+		}
+	}
+	return 0;
+}
+
 #define HDR0_MAGIC	0xE79B9C4F
 // Definition for Headers
 typedef struct {
@@ -230,12 +564,45 @@ typedef struct {
 	uint32_t resv0;		 // 7 Reserved, 0xFFFFFFFF
 } HDR0_TYPE;
 
+#define HDR1_MAGIC	0xE79B9C50
+// Bundle Header: All Components are installed in one Boot, in Table Order
+typedef struct {
+	uint32_t hdrmagic;   // 0 MagicHeader Type1: HDR1_MAGIC
+	uint32_t hdrsize;	 // 1 Size in Bytes (32 + 16 * comp_cnt)
+	uint32_t binsize;	 // 2 Size of all following Component Blocks
+	uint32_t comp_cnt;	 // 3 Number of Components in following Table
+	uint32_t crc32;		 // 4 CRC32 of Component Table and all Component Blocks
+	uint32_t timestamp;	 // 5 UnixSeconds of this file
+	uint32_t binary_start; // 6 StartAddress Binary (Parameter 2 of 'h')
+	uint32_t resv0;		 // 7 Reserved, 0xFFFFFFFF
+} HDR1_TYPE;
+
+// Component Table Entry (follows HDR1), Blocks follow the Table in same Order
+#define COMP_APP	0
+#define COMP_SOFTDEVICE	1
+#define COMP_BOOTLOADER	2
+typedef struct {
+	uint32_t binload;	// 0 Adr0 of this Component in Flash
+	uint32_t binsize;	// 1 Size of this Component Block
+	uint32_t crc32;		// 2 CRC32 of this Component Block
+	uint32_t comptype;	// 3 COMP_xxx
+} HDR1_COMP_TYPE;
+
+#define MAX_COMP	8
+HDR1_COMP_TYPE comp_tab[MAX_COMP];	// Set by Option 'k'
+int comp_cnt;
+
 /* Write the opt. Header to outf */
 int write_header(FILE* outf, int hdrtype, int min_bin_addr, int anz, uint32_t par1) {
+	double t0 = get_secs();
 	uint32_t crc32 = fs_track_crc32(&binbuf[min_bin_addr], anz, 0xFFFFFFFF);
 	//printf("CRC32: %08X\n", crc32);
 	HDR0_TYPE hdr0;
 
+	st_secs[ST_CRC] += get_secs() - t0;
+	st_bytes[ST_CRC] += anz;
+	t0 = get_secs();
+
 	switch (hdrtype) {
 	case 0:
 		assert(sizeof(hdr0) == 32);
@@ -251,8 +618,12 @@ int write_header(FILE* outf, int hdrtype, int min_bin_addr, int anz, uint32_t pa
 			printf("ERROR: File Write Error!\n");
 			return -20;
 		}
-		printf("Header Type 0: Binary Start: 0x%X (%d Bytes)\n", min_bin_addr,anz);
-		printf("Timestamp: 0x%X\n", hdr0.timestamp);
+		st_secs[ST_HEADER] += get_secs() - t0;
+		st_bytes[ST_HEADER] += sizeof(hdr0);
+		if (verbose) {
+			printf("Header Type 0: Binary Start: 0x%X (%d Bytes)\n", min_bin_addr, anz);
+			printf("Timestamp: 0x%X\n", hdr0.timestamp);
+		}
 
 		break;
 	default:
@@ -262,36 +633,1310 @@ int write_header(FILE* outf, int hdrtype, int min_bin_addr, int anz, uint32_t pa
 	return 0; // Hdr. OK	
 }
 
+/* Write Header Type 1 and all Components (Bundle) to outf */
+int write_bundle(FILE* outf, uint32_t par1) {
+	HDR1_TYPE hdr1;
+	uint32_t crc32, binsize = 0;
+	int i, j, anz;
+	double t0;
+
+	if (!comp_cnt) {
+		printf("ERROR: No Components (Option 'k')\n");
+		return -23;
+	}
+	for (i = 0; i < comp_cnt; i++) {
+		// Shrink to used Data in Range
+		anz = comp_tab[i].binsize;
+		while (anz > 0 && !usedbuf[comp_tab[i].binload + anz - 1]) anz--;
+		if (!anz) {
+			printf("ERROR: Component %d (Addr: 0x%X) is empty\n", i, comp_tab[i].binload);
+			return -24;
+		}
+		comp_tab[i].binsize = anz;
+		comp_tab[i].crc32 = fs_track_crc32(&binbuf[comp_tab[i].binload], anz, 0xFFFFFFFF);
+		for (j = 0; j < i; j++) {
+			if (comp_tab[i].binload < comp_tab[j].binload + comp_tab[j].binsize && comp_tab[j].binload < comp_tab[i].binload + anz) {
+				printf("ERROR: Components %d and %d overlap\n", j, i);
+				return -25;
+			}
+		}
+		binsize += anz;
+	}
+	t0 = get_secs();
+	crc32 = fs_track_crc32((uint8_t*)comp_tab, comp_cnt * sizeof(HDR1_COMP_TYPE), 0xFFFFFFFF);
+	for (i = 0; i < comp_cnt; i++) {
+		crc32 = fs_track_crc32(&binbuf[comp_tab[i].binload], comp_tab[i].binsize, crc32);
+	}
+	st_secs[ST_CRC] += get_secs() - t0;
+	st_bytes[ST_CRC] += binsize;
+
+	assert(sizeof(hdr1) == 32 && sizeof(HDR1_COMP_TYPE) == 16);
+	hdr1.hdrmagic = HDR1_MAGIC;
+	hdr1.hdrsize = 32 + comp_cnt * sizeof(HDR1_COMP_TYPE);
+	hdr1.binsize = binsize;
+	hdr1.comp_cnt = comp_cnt;
+	hdr1.crc32 = crc32;
+	hdr1.timestamp = (uint32_t)time(NULL);	// now()
+	hdr1.binary_start = par1;
+	hdr1.resv0 = 0xFFFFFFFF;
+	t0 = get_secs();
+	if (fwrite(&hdr1, 1, sizeof(hdr1), outf) != sizeof(hdr1)
+		|| fwrite(comp_tab, sizeof(HDR1_COMP_TYPE), comp_cnt, outf) != (size_t)comp_cnt) {
+		printf("ERROR: File Write Error!\n");
+		return -20;
+	}
+	st_secs[ST_HEADER] += get_secs() - t0;
+	st_bytes[ST_HEADER] += hdr1.hdrsize;
+	printf("Header Type 1: %d Components, %d Bytes\n", comp_cnt, binsize);
+	for (i = 0; i < comp_cnt; i++) {
+		t0 = get_secs();
+		if (fwrite(&binbuf[comp_tab[i].binload], 1, comp_tab[i].binsize, outf) != comp_tab[i].binsize) {
+			printf("ERROR: File Write Error!\n");
+			return -20;
+		}
+		st_secs[ST_OUTPUT] += get_secs() - t0;
+		st_bytes[ST_OUTPUT] += comp_tab[i].binsize;
+		printf(" Component %d: Type %d Addr: 0x%X...0x%X (%d Bytes)\n", i, comp_tab[i].comptype,
+			comp_tab[i].binload, comp_tab[i].binload + comp_tab[i].binsize - 1, comp_tab[i].binsize);
+	}
+	printf("Timestamp: 0x%X\n", hdr1.timestamp);
+	return 0;
+}
+
+/* Size Report from a GNU-ld Map File (as written by SES): Sum of all Input Sections
+* per Module (Object File). Sections in RAM that are loaded (.data/.fast) count
+* for Flash too. Debug Sections are ignored */
+#define MAX_MODULES	512
+#define RAM_BASE	0x20000000
+typedef struct {
+	char name[64];
+	uint32_t flash;
+	uint32_t ram;
+} MODULE_SIZE;
+MODULE_SIZE mod_tab[MAX_MODULES];
+
+static int cmp_mod_flash(const void* a, const void* b) {
+	return ((MODULE_SIZE*)b)->flash - ((MODULE_SIZE*)a)->flash;
+}
+
+#define MAP_LINE	1024	// SES Map Lines contain the full Object Path
+static char map_line[MAP_LINE];
+
+int map_size_report(char* mapfilename) {
+	FILE* mapf;
+	char secname[MAP_LINE] = "";
+	char tok[3][MAP_LINE];
+	char* pmod;
+	int i, ntok, mod_cnt = 0, in_map = 0;
+	uint32_t addr, size, tot_flash = 0, tot_ram = 0;
+	MODULE_SIZE* pm;
+
+	mapf = fopen(mapfilename, "r");
+	if (!mapf) {
+		printf("ERROR: Can't open '%s'\n", mapfilename);
+		return -27;
+	}
+	while (fgets(map_line, MAP_LINE, mapf)) {
+		if (!strchr(map_line, '\n') && !feof(mapf)) {	// Line too long: skip Rest, ignore Line
+			while ((i = fgetc(mapf)) != EOF && i != '\n');
+			continue;
+		}
+		if (!in_map) {	// Skip 'Discarded input sections'
+			if (!strncmp(map_line, "Linker script and memory map", 28)) in_map = 1;
+			continue;
+		}
+		if (map_line[0] != ' ') continue;	// Only Input Sections are indented
+		ntok = sscanf(map_line, "%1023s %1023s %1023s", tok[0], tok[1], tok[2]);
+		if (ntok == 1 && tok[0][0] == '.') {	// Long Names: Addr/Size/Module in next Line
+			strcpy(secname, tok[0]);
+			continue;
+		}
+		if (ntok == 3 && tok[0][0] == '.' && !strncmp(tok[1], "0x", 2)) {	// ' .sec 0xADDR 0xSIZE module'
+			strcpy(secname, tok[0]);
+			ntok = sscanf(map_line, "%*s 0x%x 0x%x %1023s", &addr, &size, tok[2]);
+		}else if (ntok >= 2 && !strncmp(tok[0], "0x", 2) && secname[0]) {	// '     0xADDR 0xSIZE module'
+			ntok = sscanf(map_line, " 0x%x 0x%x %1023s", &addr, &size, tok[2]);
+		}else {
+			continue;
+		}
+		if (ntok != 3 || !size) continue;
+		if (!strncmp(secname, ".debug", 6) || !strncmp(secname, ".comment", 8) || !strncmp(secname, ".ARM.attributes", 15)) continue;
+
+		pmod = strrchr(tok[2], '/');
+		if (!pmod) pmod = strrchr(tok[2], '\\');
+		pmod = pmod ? pmod + 1 : tok[2];
+		for (i = 0; i < mod_cnt; i++) if (!strcmp(mod_tab[i].name, pmod)) break;
+		if (i == mod_cnt) {
+			if (mod_cnt >= MAX_MODULES) continue;
+			snprintf(mod_tab[i].name, sizeof(mod_tab[i].name), "%.63s", pmod);
+			mod_cnt++;
+		}
+		pm = &mod_tab[i];
+		if (addr < RAM_BASE) {
+			pm->flash += size;
+			tot_flash += size;
+		}else {
+			pm->ram += size;
+			tot_ram += size;
+			if (!strncmp(secname, ".data", 5) || !strncmp(secname, ".fast", 5)) {	// Init. Values in Flash
+				pm->flash += size;
+				tot_flash += size;
+			}
+		}
+	}
+	fclose(mapf);
+	if (!in_map || !mod_cnt) {
+		printf("ERROR: No Memory Map in '%s'\n", mapfilename);
+		return -28;
+	}
+
+	qsort(mod_tab, mod_cnt, sizeof(MODULE_SIZE), cmp_mod_flash);
+	printf("%-40s %8s %8s\n", "Module", "Flash", "RAM");
+	for (i = 0; i < mod_cnt; i++) {
+		printf("%-40s %8u %8u\n", mod_tab[i].name, mod_tab[i].flash, mod_tab[i].ram);
+	}
+	printf("%-40s %8u %8u\n", "Total", tot_flash, tot_ram);
+	return 0;
+}
+
+/* Back to empty Buffers (as after Start) */
+void reset_buffers(void) {
+	memset(binbuf, BINDEF_VAL, MAX_BUF);
+	memset(usedbuf, 0, MAX_BUF);
+	min_bin_addr = MAX_BUF - 1;
+	max_bin_addr = 0;
+	bin_bytes_cnt = 0;
+	warnings_cnt = 0;
+	total_line_cnt = 0;
+}
+
+/* Write one Intel-HEX Record */
+static void hex_record(FILE* hexf, int typ, int adr16, uint8_t* pdata, int len) {
+	uint8_t sum = (uint8_t)(len + (adr16 >> 8) + adr16 + typ);
+	fprintf(hexf, ":%02X%04X%02X", len, adr16 & 0xFFFF, typ);
+	while (len--) {
+		fprintf(hexf, "%02X", *pdata);
+		sum += *pdata++;
+	}
+	fprintf(hexf, "%02X\n", (uint8_t)(-sum));
+}
+
+/* Synthetic Intel-HEX: 'data_bytes' in Records of 'reclen', optional Gap of 256 Bytes
+* after each 4 kB. Addresses wrap at MAX_BUF, so large Files overlap (Overwrites) */
+int gen_hex(char* hexname, int data_bytes, int reclen, int gaps) {
+	FILE* hexf;
+	uint8_t rec[MAXLINE / 2];
+	uint32_t seed = (uint32_t)data_bytes;
+	int addr = 0, upper = -1, i, len;
+
+	hexf = fopen(hexname, "w");
+	if (!hexf) {
+		printf("ERROR: Can't open '%s'\n", hexname);
+		return -17;
+	}
+	while (data_bytes > 0) {
+		len = (data_bytes < reclen) ? data_bytes : reclen;
+		if (addr + len > MAX_BUF) addr = 0;
+		if ((addr >> 16) != upper) {	// Extended Linear Address
+			upper = addr >> 16;
+			rec[0] = (uint8_t)(upper >> 8);
+			rec[1] = (uint8_t)upper;
+			hex_record(hexf, 4, 0, rec, 2);
+		}
+		if (((addr & 0xFFFF) + len) > 0x10000) len = 0x10000 - (addr & 0xFFFF);	// No Record crosses 64k
+		for (i = 0; i < len; i++) {
+			seed = seed * 1103515245 + 12345;
+			rec[i] = (uint8_t)(seed >> 16);
+		}
+		hex_record(hexf, 0, addr, rec, len);
+		addr += len;
+		data_bytes -= len;
+		if (gaps && !(addr & 4095)) addr += 256;
+	}
+	hex_record(hexf, 1, 0, NULL, 0);
+	fclose(hexf);
+	return 0;
+}
+
+/* Benchmark of all Stages (Decode, Write, CRC, Parse, End-to-End) */
+#define BENCH_DEC_SIZE	(MAX_BUF / 4)	// Hex Digits fit in 'usedbuf'
+#define BENCH_HEX	"JesFsHex2Bin_bench.hex"
+#define BENCH_BIN	"JesFsHex2Bin_bench.bin"
+typedef struct {
+	const char* name;
+	int data_bytes;
+	int reclen;
+	int gaps;
+} BENCH_CASE;
+
+int bench_all(char* jsonname) {
+	static const BENCH_CASE cases[] = {
+		{ "hex_64k_r16", 64 * 1024, 16, 0 },
+		{ "hex_1m_r32_gaps", 1024 * 1024, 32, 1 },
+		{ "hex_2m_r48", 2048 * 1024, 48, 0 },
+		{ "hex_16m_r16_overlap", 16 * 1024 * 1024, 16, 1 },
+	};
+	FILE* jsonf = NULL;
+	FILE* outf;
+	char name[80];
+	double t0, t1, t2;
+	int i, n, res;
+	volatile int sink = 0;
+
+	if (jsonname) {
+		jsonf = fopen(jsonname, "w");
+		if (!jsonf) {
+			printf("ERROR: Can't open '%s'\n", jsonname);
+			return -17;
+		}
+		fprintf(jsonf, "{\n  \"tool\": \"JesFsHex2Bin\",\n  \"version\": \"" VERSION "\",\n");
+		fprintf(jsonf, "  \"crc32_engine\": %d,\n  \"crc32_table_ram\": %d,\n  \"results\": [", CRC32_ENGINE, CRC32_TABLE_RAM);
+	}
+	verbose = 0;
+
+	res = bench_crc32(jsonf);
+	if (res) goto bench_end;
+
+	// Decode: 'getbyte' / 'getuint16' on Hex Digits (in 'usedbuf')
+	for (i = 0; i < BENCH_DEC_SIZE * 2; i++) usedbuf[i] = "0123456789ABCDEF"[binbuf[i / 2] >> ((i & 1) ? 0 : 4) & 15];
+	usedbuf[BENCH_DEC_SIZE * 2] = 0;
+	pbyte = (char*)usedbuf;
+	t0 = get_secs();
+	for (i = 0; i < BENCH_DEC_SIZE; i++) sink += getbyte();
+	bench_result(jsonf, "getbyte", BENCH_DEC_SIZE, get_secs() - t0);
+	pbyte = (char*)usedbuf;
+	t0 = get_secs();
+	for (i = 0; i < BENCH_DEC_SIZE / 2; i++) sink += getuint16();
+	bench_result(jsonf, "getuint16", BENCH_DEC_SIZE, get_secs() - t0);
+
+	// Write: 'write_byte' on all of MAX_BUF
+	reset_buffers();
+	t0 = get_secs();
+	for (i = 0; i < MAX_BUF; i++) write_byte(i, i);
+	bench_result(jsonf, "write_byte", MAX_BUF, get_secs() - t0);
+
+	// Parse and End-to-End per synthetic File
+	for (n = 0; n < (int)(sizeof(cases) / sizeof(cases[0])); n++) {
+		res = gen_hex(BENCH_HEX, cases[n].data_bytes, cases[n].reclen, cases[n].gaps);
+		if (res) break;
+		reset_buffers();
+		t0 = get_secs();
+		res = read_infile(BENCH_HEX);
+		t1 = get_secs();
+		if (res) break;
+		outf = fopen(BENCH_BIN, "wb");
+		if (!outf) {
+			printf("ERROR: Can't open '%s'\n", BENCH_BIN);
+			res = -17;
+			break;
+		}
+		t2 = get_secs();
+		res = write_header(outf, 0, min_bin_addr, max_bin_addr - min_bin_addr + 1, 0);
+		if (!res && fwrite(&binbuf[min_bin_addr], 1, max_bin_addr - min_bin_addr + 1, outf) != (size_t)(max_bin_addr - min_bin_addr + 1)) res = -18;
+		fclose(outf);
+		if (res) break;
+		snprintf(name, sizeof(name), "%s.read_infile", cases[n].name);
+		bench_result(jsonf, name, cases[n].data_bytes, t1 - t0);
+		snprintf(name, sizeof(name), "%s.write_output", cases[n].name);
+		bench_result(jsonf, name, max_bin_addr - min_bin_addr + 1, get_secs() - t2);
+		snprintf(name, sizeof(name), "%s.end_to_end", cases[n].name);
+		bench_result(jsonf, name, cases[n].data_bytes, get_secs() - t0);
+	}
+	remove(BENCH_HEX);
+	remove(BENCH_BIN);
+
+bench_end:
+	verbose = 1;
+	if (jsonf) {
+		fprintf(jsonf, "\n  ]\n}\n");
+		fclose(jsonf);
+	}
+	return res;
+}
+
+/* Check one Binary File with Header Type 0 or 1 (Magic, Sizes, CRC32s).
+* Result as Text in msg. Files are mapped (POSIX) or read (Windows) */
+#define VERIFY_MSG_LEN	120
+int verify_file(char* fname, char* msg) {
+	uint8_t* pfile;
+	uint32_t flen, crc32, binsize, pos;
+	HDR0_TYPE hdr0;
+	HDR1_TYPE hdr1;
+	HDR1_COMP_TYPE comp;
+	int res = 0, i;
+#ifndef _WIN32
+	struct stat st;
+	int fd = open(fname, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st)) {
+		if (fd >= 0) close(fd);
+		snprintf(msg, VERIFY_MSG_LEN, "ERROR: Can't open");
+		return -1;
+	}
+	flen = (uint32_t)st.st_size;
+	pfile = flen ? mmap(NULL, flen, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+	close(fd);
+	if (pfile == MAP_FAILED) {
+		snprintf(msg, VERIFY_MSG_LEN, "ERROR: Can't map");
+		return -1;
+	}
+#else
+	FILE* inf = fopen(fname, "rb");
+	if (!inf) {
+		snprintf(msg, VERIFY_MSG_LEN, "ERROR: Can't open");
+		return -1;
+	}
+	fseek(inf, 0, SEEK_END);
+	flen = (uint32_t)ftell(inf);
+	fseek(inf, 0, SEEK_SET);
+	pfile = malloc(flen ? flen : 1);
+	if (!pfile || fread(pfile, 1, flen, inf) != flen) {
+		fclose(inf);
+		free(pfile);
+		snprintf(msg, VERIFY_MSG_LEN, "ERROR: Can't read");
+		return -1;
+	}
+	fclose(inf);
+#endif
+
+	if (flen < 32) {
+		snprintf(msg, VERIFY_MSG_LEN, "ERROR: File too short (%u Bytes)", flen);
+		res = -2;
+	}else if (*(uint32_t*)pfile == HDR0_MAGIC) {
+		memcpy(&hdr0, pfile, sizeof(hdr0));
+		if (hdr0.hdrsize != sizeof(hdr0)) {
+			snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR0 hdrsize %u", hdr0.hdrsize);
+			res = -3;
+		}else if (hdr0.binsize != flen - hdr0.hdrsize) {
+			snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR0 binsize %u, File has %u", hdr0.binsize, flen - hdr0.hdrsize);
+			res = -4;
+		}else if ((crc32 = fs_track_crc32(pfile + hdr0.hdrsize, hdr0.binsize, 0xFFFFFFFF)) != hdr0.crc32) {
+			snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR0 CRC32 %08X, expected %08X", crc32, hdr0.crc32);
+			res = -5;
+		}else {
+			snprintf(msg, VERIFY_MSG_LEN, "OK: HDR0 Addr: 0x%X, %u Bytes, CRC32 %08X", hdr0.binload, hdr0.binsize, hdr0.crc32);
+		}
+	}else if (*(uint32_t*)pfile == HDR1_MAGIC) {
+		memcpy(&hdr1, pfile, sizeof(hdr1));
+		if (hdr1.comp_cnt < 1 || hdr1.comp_cnt > MAX_COMP || hdr1.hdrsize != 32 + hdr1.comp_cnt * sizeof(HDR1_COMP_TYPE) || hdr1.hdrsize > flen) {
+			snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR1 hdrsize %u (%u Components)", hdr1.hdrsize, hdr1.comp_cnt);
+			res = -3;
+		}else if (hdr1.binsize != flen - hdr1.hdrsize) {
+			snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR1 binsize %u, File has %u", hdr1.binsize, flen - hdr1.hdrsize);
+			res = -4;
+		}else if ((crc32 = fs_track_crc32(pfile + 32, flen - 32, 0xFFFFFFFF)) != hdr1.crc32) {
+			snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR1 CRC32 %08X, expected %08X", crc32, hdr1.crc32);
+			res = -5;
+		}else {
+			for (binsize = 0, pos = hdr1.hdrsize, i = 0; i < (int)hdr1.comp_cnt; i++) {
+				memcpy(&comp, pfile + 32 + i * sizeof(comp), sizeof(comp));
+				if (comp.binsize > flen - pos || fs_track_crc32(pfile + pos, comp.binsize, 0xFFFFFFFF) != comp.crc32) {
+					snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR1 Component %d", i);
+					res = -6;
+					break;
+				}
+				pos += comp.binsize;
+				binsize += comp.binsize;
+			}
+			if (!res && binsize != hdr1.binsize) {
+				snprintf(msg, VERIFY_MSG_LEN, "ERROR: HDR1 Components %u Bytes, binsize %u", binsize, hdr1.binsize);
+				res = -4;
+			}
+			if (!res) snprintf(msg, VERIFY_MSG_LEN, "OK: HDR1 %u Components, %u Bytes, CRC32 %08X", hdr1.comp_cnt, hdr1.binsize, hdr1.crc32);
+		}
+	}else {
+		snprintf(msg, VERIFY_MSG_LEN, "ERROR: Unknown Header Magic %08X", *(uint32_t*)pfile);
+		res = -2;
+	}
+
+#ifndef _WIN32
+	munmap(pfile, flen);
+#else
+	free(pfile);
+#endif
+	return res;
+}
+
+/* Verify all Files (in parallel, if compiled with OpenMP), Results in Order */
+int verify_files(int fcnt, char** fnames) {
+	char(*msgs)[VERIFY_MSG_LEN];
+	int* results;
+	int i, errs = 0;
+
+	msgs = malloc(fcnt * sizeof(*msgs));
+	results = malloc(fcnt * sizeof(int));
+	if (!msgs || !results) {
+		printf("ERROR: Out of Memory\n");
+		return -30;
+	}
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (i = 0; i < fcnt; i++) {
+		results[i] = verify_file(fnames[i], msgs[i]);
+	}
+	for (i = 0; i < fcnt; i++) {
+		printf("%s: %s\n", fnames[i], msgs[i]);
+		if (results[i]) errs++;
+	}
+	printf("Verified %d Files, %d Errors\n", fcnt, errs);
+	free(msgs);
+	free(results);
+	return errs ? -29 : 0;
+}
+
+/* Print Statistics ('--stats') */
+void print_stats(void) {
+	static const char* st_names[ST_CNT] = { "open/read", "decode+checksum", "merge", "crc32", "header write", "output write" };
+	int i;
+	printf("\nStatistics:\n");
+	for (i = 0; i < ST_CNT; i++) {
+		printf("  %-16s %10.0f Bytes %9.3f msec", st_names[i], st_bytes[i], st_secs[i] * 1000.0);
+		if (st_secs[i] > 0) printf(" %8.1f MB/s", st_bytes[i] / st_secs[i] / 1e6);
+		printf("\n");
+	}
+	printf("  Records: Data:%d End:%d ExtSeg:%d StartSeg:%d ExtLin:%d StartLin:%d\n",
+		rec_type_cnt[0], rec_type_cnt[1], rec_type_cnt[2], rec_type_cnt[3], rec_type_cnt[4], rec_type_cnt[5]);
+	printf("  Overwritten Bytes: %d\n", warnings_cnt);
+	printf("  Buffers: %d Bytes (static)", (int)(sizeof(binbuf) + sizeof(usedbuf)));
+#ifndef _WIN32
+	{
+		struct rusage ru;
+		if (!getrusage(RUSAGE_SELF, &ru)) printf(", Peak RSS: %ld kB", ru.ru_maxrss);
+	}
+#endif
+	printf("\n");
+}
+
+/* Write one Output File from the merged Input */
+int write_output(OUT_SPEC* po) {
+	FILE* outf;
+	int res = 0, anz;
+	int low_addr = (po->low_addr >= 0) ? po->low_addr : min_bin_addr;
+	double t0;
+
+	anz = max_bin_addr - low_addr + 1;
+	if (anz <= 0) {
+		printf("ERROR: No Data to Write\n");
+		return -16;
+	}
+	if (po->hdrtype == 1) printf("Write '%s' (Bundle)\n", po->name);
+	else printf("Write '%s', %d Bytes (Addr: 0x%X...0x%X)\n", po->name, anz, low_addr, max_bin_addr);
+	outf = fopen(po->name, "wb");
+	if (!outf) {
+		printf("ERROR: Can't open '%s'\n", po->name);
+		return -17;
+	}
+	if (po->hdrtype == 1) {
+		res = write_bundle(outf, po->par1);
+	}else {
+		if (po->hdrtype >= 0) res = write_header(outf, po->hdrtype, low_addr, anz, po->par1);
+		if (!res) {
+			t0 = get_secs();
+			if (fwrite(&binbuf[low_addr], 1, anz, outf) != anz) {
+				printf("ERROR: Write Error '%s'\n", po->name);
+				res = -18;
+			}
+			st_secs[ST_OUTPUT] += get_secs() - t0;
+			st_bytes[ST_OUTPUT] += anz;
+		}
+	}
+	t0 = get_secs();
+	fclose(outf);
+	st_secs[ST_OUTPUT] += get_secs() - t0;
+	return res;
+}
+
+/* Regions from SES Projects ('-l'): Each Project's FLASH_START/FLASH_SIZE (from
+* 'linker_section_placement_macros'), all extra MemorySegments of its Placement
+* File (Settings, MBR Params, UICR Words), MBR, SoftDevice and App. The End of the
+* SoftDevice is taken from its Info Struct (in the Input) or '--split=PREFIX,SD_END',
+* never guessed. '--split=PREFIX' writes one File per Region that contains Data */
+#define MAX_REGIONS	16
+#define MBR_SIZE	0x1000	// nRF52 MBR
+#define SD_INFO_ADDR	(MBR_SIZE + 0x2000)	// SoftDevice Info Struct (nrf_sdm.h)
+#define SD_MAGIC	0x51B1E5DB	// at SD_INFO_ADDR + 4, SD End (incl. MBR) at + 8
+typedef struct {
+	char name[48];
+	uint32_t start;
+	uint32_t end;	// Exclusive
+} REGION;
+REGION reg_tab[MAX_REGIONS];
+int reg_cnt;
+uint32_t split_sd_end;	// 0: from SD Info Struct
+
+/* Read a whole File, 0-terminated (malloc) */
+static uint8_t* read_bin_file(char* fname, uint32_t* plen) {
+	FILE* inf;
+	uint8_t* pdata;
+	long flen;
+	inf = fopen(fname, "rb");
+	if (!inf) return NULL;
+	fseek(inf, 0, SEEK_END);
+	flen = ftell(inf);
+	fseek(inf, 0, SEEK_SET);
+	pdata = malloc(flen + 1);
+	if (pdata && fread(pdata, 1, flen, inf) != (size_t)flen) {
+		free(pdata);
+		pdata = NULL;
+	}
+	if (pdata) {
+		pdata[flen] = 0;
+		*plen = (uint32_t)flen;
+	}
+	fclose(inf);
+	return pdata;
+}
+
+static char* read_text_file(char* fname) {
+	uint32_t flen;
+	return (char*)read_bin_file(fname, &flen);
+}
+
+/* Copy Value of 'attr="..."' (searched from ptxt to pend or end) to val */
+static int get_attr(char* ptxt, char* pend, char* attr, char* val, int vlen) {
+	char key[64];
+	char* pc;
+	int n = 0;
+	snprintf(key, sizeof(key), " %s=\"", attr);
+	pc = strstr(ptxt, key);
+	if (!pc || (pend && pc > pend)) return -1;
+	pc += strlen(key);
+	while (*pc && *pc != '"' && n < vlen - 1) val[n++] = *pc++;
+	val[n] = 0;
+	return 0;
+}
+
+/* Number or '$(MACRO)' from 'K=V;K=V..' */
+static int eval_value(char* macros, char* expr, uint32_t* pval) {
+	char name[64];
+	char* pc;
+	int n;
+	if (!strncmp(expr, "$(", 2)) {
+		for (n = 0; expr[n + 2] && expr[n + 2] != ')' && n < (int)sizeof(name) - 2; n++) name[n] = expr[n + 2];
+		name[n++] = '=';
+		name[n] = 0;
+		for (pc = macros; (pc = strstr(pc, name)) != NULL; pc++) {
+			if (pc == macros || pc[-1] == ';') break;
+		}
+		if (!pc) return -1;
+		expr = pc + n;
+	}
+	*pval = strtoul(expr, &pc, 0);
+	return (pc == expr) ? -1 : 0;
+}
+
+static int add_region(char* name, uint32_t start, uint32_t size) {
+	if (reg_cnt >= MAX_REGIONS) {
+		printf("ERROR: Max. %d Regions\n", MAX_REGIONS);
+		return -33;
+	}
+	snprintf(reg_tab[reg_cnt].name, sizeof(reg_tab[reg_cnt].name), "%s", name);
+	reg_tab[reg_cnt].start = start;
+	reg_tab[reg_cnt].end = start + size;
+	reg_cnt++;
+	return 0;
+}
+
+/* Read Regions of one SES Project (.emProject and its Placement File) */
+int read_layout(char* projname) {
+	char name[48], val[256], xmlname[512];
+	char* pproj = NULL;
+	char* pxml = NULL;
+	char* macros = NULL;
+	char* pc;
+	char* pend;
+	uint32_t start, size;
+	int res = -34, n;
+
+	pproj = read_text_file(projname);
+	if (!pproj) {
+		printf("ERROR: Can't open '%s'\n", projname);
+		return -17;
+	}
+	macros = malloc(strlen(pproj) + 1);
+	if (!macros || get_attr(pproj, NULL, "linker_section_placement_macros", macros, (int)strlen(pproj) + 1)
+		|| eval_value(macros, "$(FLASH_START)", &start) || eval_value(macros, "$(FLASH_SIZE)", &size)) {
+		printf("ERROR: No FLASH_START/FLASH_SIZE in '%s'\n", projname);
+		goto layout_end;
+	}
+	pc = strstr(pproj, "<project ");
+	if (!pc || get_attr(pc - 1, strchr(pc, '>'), "Name", name, sizeof(name))) strcpy(name, "project");
+	if (add_region(name, start, size)) goto layout_end;
+
+	// Placement File is relative to the Project
+	if (get_attr(pproj, NULL, "linker_section_placement_file", val, sizeof(val))) {
+		res = 0;	// Only Flash Region
+		goto layout_end;
+	}
+	snprintf(xmlname, sizeof(xmlname), "%s", projname);
+	pc = strrchr(xmlname, '/');
+	if (!pc) pc = strrchr(xmlname, '\\');
+	n = pc ? (int)(pc - xmlname + 1) : 0;
+	snprintf(xmlname + n, sizeof(xmlname) - n, "%s", val);
+	pxml = read_text_file(xmlname);
+	if (!pxml) {
+		printf("ERROR: Can't open '%s'\n", xmlname);
+		res = -17;
+		goto layout_end;
+	}
+	for (pc = pxml; (pc = strstr(pc, "<MemorySegment ")) != NULL; pc++) {
+		pend = strchr(pc, '>');
+		if (get_attr(pc - 1, pend, "name", name, sizeof(name))) continue;
+		if (!strcmp(name, "FLASH") || !strncmp(name, "RAM", 3)) continue;	// Whole Memories
+		if (get_attr(pc - 1, pend, "start", val, sizeof(val)) || eval_value(macros, val, &start)) continue;
+		if (get_attr(pc - 1, pend, "size", val, sizeof(val)) || eval_value(macros, val, &size)) continue;
+		for (n = 0; n < reg_cnt; n++) if (!strcmp(reg_tab[n].name, name)) break;	// Shared by Projects
+		if (n < reg_cnt) continue;
+		if (add_region(name, start, size)) goto layout_end;
+	}
+	res = 0;
+
+layout_end:
+	free(pproj);
+	free(pxml);
+	free(macros);
+	return res;
+}
+
+/* Pointers to Data and Use-Counters for a Region, NULL if not in Buffers */
+static uint8_t* region_data(REGION* pr, uint8_t** pused) {
+	if (pr->end <= MAX_BUF) {
+		*pused = &usedbuf[pr->start];
+		return &binbuf[pr->start];
+	}
+	if (pr->start >= UICR_START && pr->end <= UICR_START + UICR_SIZE) {
+		*pused = &uicrused[pr->start - UICR_START];
+		return &uicrbuf[pr->start - UICR_START];
+	}
+	return NULL;
+}
+
+/* End of the SoftDevice from its Info Struct in the Input, 0 if not there */
+static uint32_t sd_info_end(void) {
+	uint32_t magic, sd_end, i;
+	for (i = SD_INFO_ADDR + 4; i < SD_INFO_ADDR + 12; i++) if (!usedbuf[i]) return 0;
+	memcpy(&magic, &binbuf[SD_INFO_ADDR + 4], 4);
+	memcpy(&sd_end, &binbuf[SD_INFO_ADDR + 8], 4);
+	if (magic != SD_MAGIC || sd_end <= SD_INFO_ADDR || sd_end > MAX_BUF) return 0;
+	return sd_end;
+}
+
+/* Add Regions 'softdevice' and 'app' (if not a Project) for a known SD End */
+static int add_sd_regions(uint32_t sd_end) {
+	uint32_t app_end = NRF_FLASH_END;
+	int n, app_project = 0;
+	for (n = 0; n < reg_cnt; n++) {
+		if (reg_tab[n].start < sd_end && reg_tab[n].end > MBR_SIZE) {
+			printf("ERROR: SoftDevice End 0x%X overlaps Region '%s'\n", sd_end, reg_tab[n].name);
+			return -34;
+		}
+		if (reg_tab[n].start == sd_end) app_project = 1;
+		if (reg_tab[n].start >= sd_end && reg_tab[n].start < app_end) app_end = reg_tab[n].start;
+	}
+	if (add_region("softdevice", MBR_SIZE, sd_end - MBR_SIZE)) return -33;
+	if (!app_project && app_end > sd_end && add_region("app", sd_end, app_end - sd_end)) return -33;
+	return 0;
+}
+
+/* Write one File 'PREFIX_REGION.bin' per used Region (opt. with Header Type 0) */
+int write_split(char* prefix, int hdrtype) {
+	char outname[512];
+	uint8_t* pdata;
+	uint8_t* pused;
+	FILE* outf;
+	REGION* pr;
+	uint32_t i, first, last, sd_end, covered = 0, total = 0;
+	int n, res = 0;
+
+	if (!reg_cnt) {
+		printf("ERROR: No Regions (Option 'l')\n");
+		return -34;
+	}
+	sd_end = sd_info_end();
+	if (split_sd_end) {
+		if (sd_end && sd_end != split_sd_end) {
+			printf("ERROR: SD_END 0x%X, but SoftDevice Info Struct says 0x%X\n", split_sd_end, sd_end);
+			return -34;
+		}
+		sd_end = split_sd_end;
+	}
+	if (sd_end) {
+		res = add_sd_regions(sd_end);
+		if (res) return res;
+	}else {
+		printf("WARNING: SoftDevice End unknown (no Info Struct, use '--split=PREFIX,SD_END'), no 'softdevice'/'app' Region\n");
+	}
+	if (add_region("mbr", 0, MBR_SIZE)) return -33;
+
+	for (n = 0; n < reg_cnt && !res; n++) {
+		pr = &reg_tab[n];
+		pdata = region_data(pr, &pused);
+		if (!pdata) continue;
+		for (first = 0; first < pr->end - pr->start && !pused[first]; first++);
+		if (first == pr->end - pr->start) continue;	// No Data
+		for (last = pr->end - pr->start - 1; !pused[last]; last--);
+		for (i = first; i <= last; i++) if (pused[i]) covered++;
+		snprintf(outname, sizeof(outname), "%.400s_%.47s.bin", prefix, pr->name);
+		printf("Write '%s', %u Bytes (Addr: 0x%X...0x%X)\n", outname, last - first + 1, pr->start + first, pr->start + last);
+		outf = fopen(outname, "wb");
+		if (!outf) {
+			printf("ERROR: Can't open '%s'\n", outname);
+			return -17;
+		}
+		if (hdrtype == 0 && pr->end <= MAX_BUF) {	// No Header for UICR
+			res = write_header(outf, 0, pr->start + first, last - first + 1, pr->start);
+		}
+		if (!res && fwrite(pdata + first, 1, last - first + 1, outf) != last - first + 1) {
+			printf("ERROR: Write Error '%s'\n", outname);
+			res = -18;
+		}
+		fclose(outf);
+	}
+	if (!res) {
+		for (i = min_bin_addr; (int)i <= max_bin_addr; i++) if (usedbuf[i]) total++;
+		for (i = 0; i < UICR_SIZE; i++) if (uicrused[i]) total++;
+		if (covered < total) printf("WARNING: %u Input Bytes outside of all Regions (not written)\n", total - covered);
+	}
+	return res;
+}
+
+/* Chunk Store ('--store=DIR'): Output Files are cut into Content-Defined Chunks
+* (Gear Rolling Hash), each Chunk is stored once as 'DIR/KEY.chk', each File as
+* Manifest 'DIR/NAME_CRC32.mft' (List of Keys, one per Release, never overwritten).
+* KEY is FNV-1a-64 + CRC32 of the Chunk, an existing Chunk File is compared before
+* it is reused */
+#define CHUNK_MIN	1024
+#define CHUNK_MASK	0x0FFF	// Avg. 4 kB
+#define CHUNK_MAX	16384
+#define MFT_MAGIC	"JesFsChunks 1"
+static uint64_t gear_tab[256];
+
+static void gear_init(void) {
+	uint64_t x = 0x4A65734673ULL;	// Fixed: Keys must be stable
+	int i;
+	for (i = 0; i < 256; i++) {	// splitmix64
+		x += 0x9E3779B97F4A7C15ULL;
+		gear_tab[i] = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		gear_tab[i] = (gear_tab[i] ^ (gear_tab[i] >> 27)) * 0x94D049BB133111EBULL;
+		gear_tab[i] ^= gear_tab[i] >> 31;
+	}
+}
+
+/* Length of next Chunk */
+static uint32_t chunk_len(uint8_t* pdata, uint32_t len) {
+	uint64_t h = 0;
+	uint32_t i;
+	if (len <= CHUNK_MIN) return len;
+	if (len > CHUNK_MAX) len = CHUNK_MAX;
+	for (i = 0; i < len; i++) {
+		h = (h << 1) + gear_tab[pdata[i]];
+		if (i >= CHUNK_MIN && !((h >> 48) & CHUNK_MASK)) return i + 1;
+	}
+	return len;
+}
+
+static void chunk_key(uint8_t* pdata, uint32_t len, char* key) {
+	uint64_t fnv = 0xCBF29CE484222325ULL;
+	uint32_t i;
+	for (i = 0; i < len; i++) {
+		fnv ^= pdata[i];
+		fnv *= 0x100000001B3ULL;
+	}
+	sprintf(key, "%016llX%08X", (unsigned long long)fnv, fs_track_crc32(pdata, len, 0xFFFFFFFF));
+}
+
+int store_file(char* dir, char* fname) {
+	char path[600], mftname[600], tmpname[610], chkname[610], key[32];
+	uint8_t* pdata;
+	uint8_t* pold;
+	uint32_t flen, fcrc, pos, clen, olen, mlen, mcrc;
+	int nchunks = 0, nnew = 0, bnew = 0, res = 0, n;
+	char* pbase;
+	char* pc;
+	FILE* mftf;
+	FILE* chkf;
+
+	pdata = read_bin_file(fname, &flen);
+	if (!pdata) {
+		printf("ERROR: Can't open '%s'\n", fname);
+		return -17;
+	}
+	fcrc = fs_track_crc32(pdata, flen, 0xFFFFFFFF);
+	pbase = strrchr(fname, '/');
+	if (!pbase) pbase = strrchr(fname, '\\');
+	pbase = pbase ? pbase + 1 : fname;
+	pc = strrchr(pbase, '.');	// Without Extension
+	n = (pc && pc != pbase) ? (int)(pc - pbase) : (int)strlen(pbase);
+	if (n > 180) n = 180;
+	snprintf(mftname, sizeof(mftname), "%.400s/%.*s_%08X.mft", dir, n, pbase, fcrc);
+
+	mftf = fopen(mftname, "r");	// Same Release already stored?
+	if (mftf) {
+		if (fgets(in_line, MAXLINE, mftf) && !strncmp(in_line, MFT_MAGIC, strlen(MFT_MAGIC))
+			&& fscanf(mftf, "%u %x", &mlen, &mcrc) == 2 && mlen == flen && mcrc == fcrc) {
+			printf("Stored '%s': already in '%s'\n", fname, mftname);
+		}else {
+			printf("ERROR: Manifest '%s' exists (not overwritten)\n", mftname);
+			res = -35;
+		}
+		fclose(mftf);
+		free(pdata);
+		return res;
+	}
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", mftname);	// Renamed if complete
+	mftf = fopen(tmpname, "w");
+	if (!mftf) {
+		printf("ERROR: Can't open '%s'\n", tmpname);
+		free(pdata);
+		return -17;
+	}
+	fprintf(mftf, MFT_MAGIC "\n%u %08X\n", flen, fcrc);
+	for (pos = 0; pos < flen; pos += clen) {
+		clen = chunk_len(pdata + pos, flen - pos);
+		chunk_key(pdata + pos, clen, key);
+		fprintf(mftf, "%s %u\n", key, clen);
+		nchunks++;
+		snprintf(path, sizeof(path), "%.400s/%s.chk", dir, key);
+		pold = read_bin_file(path, &olen);
+		if (pold) {	// Known Chunk: must be identical
+			if (olen != clen || memcmp(pold, pdata + pos, clen)) {
+				printf("ERROR: Chunk Collision '%s'\n", path);
+				res = -35;
+			}
+			free(pold);
+			if (res) break;
+			continue;
+		}
+		snprintf(chkname, sizeof(chkname), "%s.tmp", path);	// Renamed if complete
+		chkf = fopen(chkname, "wb");
+		if (!chkf) {
+			printf("ERROR: Can't open '%s'\n", chkname);
+			res = -17;
+			break;
+		}
+		if (fwrite(pdata + pos, 1, clen, chkf) != clen) res = -18;
+		if (fclose(chkf)) res = -18;
+		if (!res && rename(chkname, path)) res = -18;
+		if (res) {
+			printf("ERROR: Write Error '%s'\n", path);
+			remove(chkname);
+			break;
+		}
+		nnew++;
+		bnew += clen;
+	}
+	if (ferror(mftf) && !res) {
+		printf("ERROR: Write Error '%s'\n", tmpname);
+		res = -18;
+	}
+	if (fclose(mftf) && !res) {
+		printf("ERROR: Write Error '%s'\n", tmpname);
+		res = -18;
+	}
+	if (!res && rename(tmpname, mftname)) {
+		printf("ERROR: Can't rename '%s'\n", tmpname);
+		res = -18;
+	}
+	if (res) remove(tmpname);
+	free(pdata);
+	if (!res) printf("Stored '%s' as '%s': %d Chunks, %d new (%d Bytes)\n", fname, mftname, nchunks, nnew, bnew);
+	return res;
+}
+
+/* Rebuild a File from its Manifest ('--unpack=MANIFEST,OUTFILE') */
+int unpack_file(char* arg) {
+	char mftname[512], path[600], key[40], dir[512];
+	char* pc;
+	uint8_t* pchunk;
+	uint32_t flen, fcrc, clen, olen, pos = 0, crc = 0xFFFFFFFF;
+	FILE* mftf;
+	FILE* outf;
+	int res = 0, n;
+
+	pc = strrchr(arg, ',');
+	if (!pc || pc == arg || !pc[1] || pc - arg >= (int)sizeof(mftname)) {
+		printf("ERROR: Option Format!\n");
+		return -21;
+	}
+	memcpy(mftname, arg, pc - arg);
+	mftname[pc - arg] = 0;
+	snprintf(dir, sizeof(dir), "%s", mftname);	// Chunks are next to the Manifest
+	pc = strrchr(dir, '/');
+	if (!pc) pc = strrchr(dir, '\\');
+	if (pc) *pc = 0;
+	else strcpy(dir, ".");
+
+	mftf = fopen(mftname, "r");
+	if (!mftf) {
+		printf("ERROR: Can't open '%s'\n", mftname);
+		return -17;
+	}
+	if (!fgets(in_line, MAXLINE, mftf) || strncmp(in_line, MFT_MAGIC, strlen(MFT_MAGIC))
+		|| fscanf(mftf, "%u %x", &flen, &fcrc) != 2) {
+		printf("ERROR: No Manifest '%s'\n", mftname);
+		fclose(mftf);
+		return -36;
+	}
+	outf = fopen(strrchr(arg, ',') + 1, "wb");
+	if (!outf) {
+		printf("ERROR: Can't open '%s'\n", strrchr(arg, ',') + 1);
+		fclose(mftf);
+		return -17;
+	}
+	while (fscanf(mftf, "%39s %u", key, &clen) == 2) {
+		for (n = 0; key[n] && isxdigit((unsigned char)key[n]); n++);
+		if (n != 24 || key[n]) {	// Only Keys from chunk_key() build a Path
+			printf("ERROR: Bad Key '%s' in '%s'\n", key, mftname);
+			res = -36;
+			break;
+		}
+		snprintf(path, sizeof(path), "%.400s/%s.chk", dir, key);
+		pchunk = read_bin_file(path, &olen);
+		if (!pchunk || olen != clen) {
+			printf("ERROR: Chunk '%s' missing or wrong\n", path);
+			free(pchunk);
+			res = -36;
+			break;
+		}
+		crc = fs_track_crc32(pchunk, clen, crc);
+		if (fwrite(pchunk, 1, clen, outf) != clen) res = -18;
+		free(pchunk);
+		if (res) break;
+		pos += clen;
+	}
+	fclose(outf);
+	fclose(mftf);
+	if (!res && (pos != flen || crc != fcrc)) {
+		printf("ERROR: Unpacked File wrong (%u Bytes, CRC32 %08X)\n", pos, crc);
+		res = -36;
+	}
+	if (!res) printf("Unpacked '%s': %u Bytes, CRC32 %08X\n", strrchr(arg, ',') + 1, pos, crc);
+	return res;
+}
+
+/* Packetizer ('--packets=MTU'): 'OUTFILE.pkt' is the Output File in Packets of
+* MTU Bytes, each a PKT_HDR and (MTU - 16) Data Bytes (last one shorter), in
+* File Order, so the Receiver can append the Data directly to the JesFs File.
+* 'OUTFILE.map' (Text) lists all Blocks as Resume Map for '--resume' */
+#define PKT_MAP_MAGIC	"JesFsPackets 1"
+#define PKT_MTU_MIN	20
+#define PKT_MTU_MAX	1024
+typedef struct {
+	uint32_t offset;	// 0 Offset of Data in File
+	uint32_t blk_idx;	// 1 Block Number
+	uint16_t len;		// 2 Data Bytes in this Packet
+	uint16_t resv0;		// 2 Reserved, 0xFFFF
+	uint32_t crc32;		// 3 CRC32 of the Data in this Packet
+} PKT_HDR;
+
+int write_packets(char* fname, int mtu) {
+	char name[600];
+	uint8_t* pdata;
+	uint32_t flen, pos, dlen;
+	PKT_HDR phdr;
+	FILE* pktf;
+	FILE* mapf;
+	int res = 0, blk = 0;
+
+	pdata = read_bin_file(fname, &flen);
+	if (!pdata) {
+		printf("ERROR: Can't open '%s'\n", fname);
+		return -17;
+	}
+	mapf = NULL;
+	snprintf(name, sizeof(name), "%.580s.pkt", fname);
+	pktf = fopen(name, "wb");
+	if (pktf) {
+		snprintf(name, sizeof(name), "%.580s.map", fname);
+		mapf = fopen(name, "w");
+	}
+	if (!pktf || !mapf) {
+		printf("ERROR: Can't open '%s'\n", name);
+		res = -17;
+		goto pkt_end;
+	}
+	dlen = mtu - sizeof(PKT_HDR);
+	fprintf(mapf, PKT_MAP_MAGIC "\n%u %d %u %08X\n", flen, mtu, (flen + dlen - 1) / dlen, fs_track_crc32(pdata, flen, 0xFFFFFFFF));
+	for (pos = 0; pos < flen; pos += phdr.len, blk++) {
+		phdr.offset = pos;
+		phdr.len = (uint16_t)((flen - pos < dlen) ? flen - pos : dlen);
+		phdr.blk_idx = (uint32_t)blk;
+		phdr.resv0 = 0xFFFF;
+		phdr.crc32 = fs_track_crc32(pdata + pos, phdr.len, 0xFFFFFFFF);
+		if (fwrite(&phdr, 1, sizeof(phdr), pktf) != sizeof(phdr) || fwrite(pdata + pos, 1, phdr.len, pktf) != phdr.len) {
+			printf("ERROR: Write Error '%s.pkt'\n", fname);
+			res = -18;
+			break;
+		}
+		fprintf(mapf, "%d %u %u %08X\n", blk, pos, phdr.len, phdr.crc32);
+	}
+	if (!res) printf("Packets '%s.pkt': %d Blocks of max. %u Bytes (MTU %d)\n", fname, blk, dlen, mtu);
+
+pkt_end:
+	if (pktf) fclose(pktf);
+	if (mapf) fclose(mapf);
+	free(pdata);
+	return res;
+}
+
+/* Compare (partially received) File with Resume Map ('--resume=MAP,FILE'):
+* Shows the first Block to send again */
+int resume_check(char* arg) {
+	char mapname[512];
+	char* pc;
+	uint8_t* pdata;
+	uint32_t flen, plen, fcrc, blk_cnt, blk, pos, len, crc;
+	uint32_t next = 0, nblk = 0, res_blk = 0xFFFFFFFF, res_pos = 0;
+	int mtu, n, bad;
+	FILE* mapf;
+
+	pc = strrchr(arg, ',');
+	if (!pc || pc == arg || !pc[1] || pc - arg >= (int)sizeof(mapname)) {
+		printf("ERROR: Option Format!\n");
+		return -21;
+	}
+	memcpy(mapname, arg, pc - arg);
+	mapname[pc - arg] = 0;
+	mapf = fopen(mapname, "r");
+	if (!mapf) {
+		printf("ERROR: Can't open '%s'\n", mapname);
+		return -17;
+	}
+	if (!fgets(in_line, MAXLINE, mapf) || strncmp(in_line, PKT_MAP_MAGIC, strlen(PKT_MAP_MAGIC))
+		|| fscanf(mapf, "%u %d %u %x", &flen, &mtu, &blk_cnt, &fcrc) != 4) {
+		printf("ERROR: No Resume Map '%s'\n", mapname);
+		fclose(mapf);
+		return -37;
+	}
+	pdata = read_bin_file(pc + 1, &plen);
+	if (!pdata) plen = 0;	// Nothing received yet
+	// Whole Map is checked (Blocks in Order, contiguous, max. MTU), Map may come from elsewhere
+	bad = (mtu < PKT_MTU_MIN || mtu > PKT_MTU_MAX);
+	while (!bad && (n = fscanf(mapf, "%u %u %u %x", &blk, &pos, &len, &crc)) == 4) {
+		if (blk != nblk || pos != next || !len || len > mtu - sizeof(PKT_HDR) || len > flen - next) {
+			bad = 1;
+			break;
+		}
+		if (res_blk == 0xFFFFFFFF && (len > plen || pos > plen - len || fs_track_crc32(pdata + pos, len, 0xFFFFFFFF) != crc)) {
+			res_blk = blk;	// First missing Block
+			res_pos = pos;
+		}
+		next += len;
+		nblk++;
+	}
+	if (!bad && (n != EOF || nblk != blk_cnt || next != flen)) bad = 1;
+	fclose(mapf);
+	if (bad) {
+		printf("ERROR: No Resume Map '%s'\n", mapname);
+		free(pdata);
+		return -37;
+	}
+	if (res_blk == 0xFFFFFFFF) {	// All Blocks OK: File must also match as a whole
+		crc = fs_track_crc32(pdata, plen, 0xFFFFFFFF);
+		free(pdata);
+		if (plen != flen || crc != fcrc) {
+			printf("ERROR: '%s' is %u Bytes (CRC32 %08X), Map says %u Bytes (CRC32 %08X)\n", pc + 1, plen, crc, flen, fcrc);
+			return -37;
+		}
+		printf("Complete: %u Blocks, %u Bytes\n", blk_cnt, flen);
+		return 0;
+	}
+	free(pdata);
+	printf("Resume at Block %u (Offset %u), %u of %u Blocks missing\n", res_blk, res_pos, blk_cnt - res_blk, blk_cnt);
+	return 1;	// Not complete
+}
+
+/* Usage Report ('--usage[=FILE.json]'): One Sweep over 'usedbuf' (min...max),
+* Run-Length coded as Unused (0), Used (1) or Overwritten (>1). Uniform Runs are
+* skipped 8 Bytes per Step */
+#define USE_UNUSED	0
+#define USE_ONCE	1
+#define USE_OVW		2
+static int use_class(uint8_t ubc) {
+	return (ubc > 1) ? USE_OVW : ubc;
+}
+
+int usage_report(char* jsonname) {
+	static const char* class_names[3] = { "unused", "used", "overwritten" };
+	static const uint64_t class_words[2] = { 0, 0x0101010101010101ULL };
+	uint32_t class_bytes[3] = { 0, 0, 0 };
+	uint32_t run_cnt[3] = { 0, 0, 0 };
+	uint64_t w;
+	FILE* jsonf = NULL;
+	int addr, run_start, cls;
+
+	if (jsonname) {
+		jsonf = fopen(jsonname, "w");
+		if (!jsonf) {
+			printf("ERROR: Can't open '%s'\n", jsonname);
+			return -17;
+		}
+		fprintf(jsonf, "{\n  \"min_addr\": %d,\n  \"max_addr\": %d,\n  \"runs\": [", min_bin_addr, max_bin_addr);
+	}
+	printf("Usage (Addr: 0x%X...0x%X):\n", min_bin_addr, max_bin_addr);
+	for (addr = min_bin_addr; addr <= max_bin_addr; ) {
+		run_start = addr;
+		cls = use_class(usedbuf[addr]);
+		addr++;
+		if (cls != USE_OVW) {	// Skip uniform 8-Byte Words
+			while (addr + 8 <= max_bin_addr + 1) {
+				memcpy(&w, &usedbuf[addr], 8);
+				if (w != class_words[cls]) break;
+				addr += 8;
+			}
+		}
+		while (addr <= max_bin_addr && use_class(usedbuf[addr]) == cls) addr++;
+		class_bytes[cls] += addr - run_start;
+		if (cls != USE_ONCE) {	// Used Runs are the Gaps between the others
+			printf("  0x%06X...0x%06X %8d Bytes %s\n", run_start, addr - 1, addr - run_start, class_names[cls]);
+		}
+		if (jsonf) {
+			fprintf(jsonf, "%s\n    {\"start\": %d, \"end\": %d, \"type\": \"%s\"}",
+				(run_cnt[0] + run_cnt[1] + run_cnt[2]) ? "," : "", run_start, addr - 1, class_names[cls]);
+		}
+		run_cnt[cls]++;
+	}
+	printf("  Total: %u Bytes used (%u Runs), %u unused (%u Runs), %u overwritten (%u Runs)\n",
+		class_bytes[USE_ONCE], run_cnt[USE_ONCE], class_bytes[USE_UNUSED], run_cnt[USE_UNUSED], class_bytes[USE_OVW], run_cnt[USE_OVW]);
+	if (jsonf) {
+		fprintf(jsonf, "\n  ],\n  \"used_bytes\": %u,\n  \"unused_bytes\": %u,\n  \"overwritten_bytes\": %u\n}\n",
+			class_bytes[USE_ONCE], class_bytes[USE_UNUSED], class_bytes[USE_OVW]);
+		fclose(jsonf);
+	}
+	return 0;
+}
 
 //------- MAIN -----------
 int main(int argc, char** argv) {
-	FILE* outf;
 	int res=0,i,anz,hdrtype=-1;
+	int file_bytes, file_ovw;
+	int opt_changed = 0;	// '-c'/'-h' after last '-o'
+	char* split_prefix = NULL;
+	char* store_dir = NULL;
+	int pkt_mtu = 0;
+	int usage = 0;
+	char* usage_json = NULL;
 	uint32_t par1 = 0;
+	double t0;
 	char* pc;
 	char* infilename = NULL;
-	char* outfilename = NULL;
 	printf("*** JesFsHex2Bin " VERSION " (C)JoEmbedded.de\n\n");
-	memset(binbuf, BINDEF_VAL, MAX_BUF);
-		
+	crc32_init();
+
 	if (argc <= 1) {
 		printf("Path: '%s'\n\n", argv[0]); // Help finding EXE
-		printf("Usage: FILE1.HEX [FILE2.HEX ...] [-cLOW_ADDR] [-hHDRTYPE] [-oOUTFILE.BIN]\n\n");
+		printf("Usage: FILE1.HEX [FILE2.HEX ...] [-cLOW_ADDR] [-hHDRTYPE] [-kLOW,END[,TYPE] ...] [-oOUTFILE.BIN] ...\n\n");
 
 		printf("Combines all .HEX-files in OUTFILE.BIN\n");
+		printf("Several '-o' are allowed, each uses the '-c'/'-h' given before it\n");
+		printf("('-c-1': lowest Addr. again, '-h-1': no Header).\n");
 		printf("If LOW_ADDR is set, only Bytes at Addr. >= LOW_ADDR will be written,\n");
 		printf("else use lowest Addr. as first Output Byte. Format: Dec. or 0x.. for Hex.\n");
-		printf("HDRTYPE specifies optional (leading) Header to Binary (see Docu).\n\n");
+		printf("HDRTYPE specifies optional (leading) Header to Binary (see Docu).\n");
+		printf("HDRTYPE 1 is a Bundle of all Components 'k' (Addr. LOW...END-1), applied\n");
+		printf("in one Boot. TYPE: 0:App 1:SoftDevice 2:Bootloader.\n");
+		printf("'--bench[=FILE.JSON]': Benchmark all Stages (opt. Results as JSON).\n");
+		printf("'--mapsize=FILE.MAP': Flash/RAM Usage per Module from Linker Map File.\n");
+		printf("'--stats': Show Timing per Phase and Counters.\n");
+		printf("'--verify FILE1.BIN [FILE2.BIN ...]': Check Files with Header Type 0/1.\n");
+		printf("'--lint': Only check all .HEX-files (Syntax, Overlaps, Map), no Output.\n");
+		printf("'-lPROJECT.EMPROJECT' (several allowed) reads Regions from SES Project\n");
+		printf("and its Placement File, '--split=PREFIX[,SD_END]' writes PREFIX_REGION.bin\n");
+		printf("for each Region with Data (Header if HDRTYPE is 0). SD_END (App Start) is\n");
+		printf("needed if the Input has no SoftDevice Info Struct.\n");
+		printf("'--store=DIR': Keep all OUTFILEs as Chunks + Manifest in DIR (Dedup.)\n");
+		printf("'--unpack=DIR/OUTFILE_CRC32.mft,FILE': Rebuild FILE from the Chunk Store.\n");
+		printf("'--packets=MTU': Also write OUTFILE.pkt (Packets of MTU Bytes with\n");
+		printf("Offset and CRC32) and OUTFILE.map (Resume Map).\n");
+		printf("'--resume=OUTFILE.map,FILE': Show first Block missing in FILE.\n");
+		printf("'--usage[=FILE.JSON]': Show unused/overwritten Ranges (opt. as JSON).\n\n");
 		return -13;
 	}
+	for (i = 1; i < argc; i++) {	// Before any Input
+		if (!strcmp(argv[i], "--stats")) stats = 1;
+		if (!strcmp(argv[i], "--lint")) lint = 1;
+	}
+	if (!lint) {
+		memset(binbuf, BINDEF_VAL, MAX_BUF);
+		memset(uicrbuf, BINDEF_VAL, UICR_SIZE);
+	}
+	t0 = get_secs();
 
 	for (i = 1; i < argc; i++) {
 		if (*argv[i] == '-') {
 			switch (*(argv[i] + 1)) {
+			case '-':	// Long Options
+				if (!strcmp(argv[i], "--bench")) {
+					return bench_all(NULL);
+				}
+				if (!strncmp(argv[i], "--bench=", 8)) {
+					return bench_all(argv[i] + 8);
+				}
+				if (!strncmp(argv[i], "--mapsize=", 10)) {
+					return map_size_report(argv[i] + 10);
+				}
+				if (!strcmp(argv[i], "--stats") || !strcmp(argv[i], "--lint")) break;
+				if (!strncmp(argv[i], "--store=", 8) && argv[i][8]) {
+					store_dir = argv[i] + 8;
+#ifdef _WIN32
+					_mkdir(store_dir);	// May exist
+#else
+					mkdir(store_dir, 0777);
+#endif
+					gear_init();
+					break;
+				}
+				if (!strncmp(argv[i], "--packets=", 10)) {
+					pkt_mtu = strtoul(argv[i] + 10, 0, 0);
+					if (pkt_mtu < PKT_MTU_MIN || pkt_mtu > PKT_MTU_MAX) {
+						printf("ERROR: MTU %d...%d\n", PKT_MTU_MIN, PKT_MTU_MAX);
+						return -21;
+					}
+					break;
+				}
+				if (!strcmp(argv[i], "--usage")) {
+					usage = 1;
+					break;
+				}
+				if (!strncmp(argv[i], "--usage=", 8)) {
+					usage = 1;
+					usage_json = argv[i] + 8;
+					break;
+				}
+				if (!strncmp(argv[i], "--resume=", 9)) {
+					return resume_check(argv[i] + 9);
+				}
+				if (!strncmp(argv[i], "--unpack=", 9)) {
+					return unpack_file(argv[i] + 9);
+				}
+				if (!strncmp(argv[i], "--split=", 8) && argv[i][8]) {
+					split_prefix = argv[i] + 8;
+					pc = strchr(split_prefix, ',');
+					if (pc) {	// Opt. SD_END
+						*pc++ = 0;
+						split_sd_end = strtoul(pc, &pc, 0);
+						if (*pc || split_sd_end <= MBR_SIZE || split_sd_end > MAX_BUF) {
+							printf("ERROR: Option Format!\n");
+							return -21;
+						}
+					}
+					break;
+				}
+				if (!strcmp(argv[i], "--verify")) {	// All following Args are Files
+					if (i + 1 >= argc) {
+						printf("ERROR: No Files to verify\n");
+						return -15;
+					}
+					return verify_files(argc - i - 1, &argv[i + 1]);
+				}
+				printf("ERROR: Unknown Option '%s'\n", argv[i]);
+				return -14;
 			case 'c':
 				lowest_output_addr = strtoul(argv[i] + 2, 0, 0);
+				opt_changed = 1;
 				break;
 			case 'h':
+				opt_changed = 1;
 				pc = argv[i] + 2;
 				hdrtype = strtoul(pc, &pc, 0);
 				if (!*pc) break;
@@ -301,12 +1946,50 @@ int main(int argc, char** argv) {
 				}
 				par1 = strtoul(pc, 0, 0);	// Start-Addr of Binary
 				break;
+			case 'k':
+				if (comp_cnt >= MAX_COMP) {
+					printf("ERROR: Max. %d Components\n", MAX_COMP);
+					return -26;
+				}
+				pc = argv[i] + 2;
+				comp_tab[comp_cnt].binload = strtoul(pc, &pc, 0);
+				if (*pc++ != ',') {
+					printf("ERROR: Option Format!\n");
+					return -21;
+				}
+				anz = strtoul(pc, &pc, 0);	// End
+				comp_tab[comp_cnt].comptype = COMP_APP;
+				if (*pc == ',') comp_tab[comp_cnt].comptype = strtoul(pc + 1, 0, 0);
+				if (anz <= (int)comp_tab[comp_cnt].binload || anz > MAX_BUF) {
+					printf("ERROR: Component Range!\n");
+					return -21;
+				}
+				if (comp_tab[comp_cnt].comptype > COMP_BOOTLOADER) {	// Bootloader can't handle others
+					printf("ERROR: Component Type %u unknown\n", comp_tab[comp_cnt].comptype);
+					return -21;
+				}
+				comp_tab[comp_cnt].binsize = anz - comp_tab[comp_cnt].binload;
+				comp_cnt++;
+				break;
+			case 'l':
+				res = read_layout(argv[i] + 2);
+				if (res) return res;
+				break;
 			case 'o':
-				outfilename = argv[i] + 2;
-				if (!strlen(outfilename)) {
+				if (out_cnt >= MAX_OUT) {
+					printf("ERROR: Max. %d Outfiles\n", MAX_OUT);
+					return -15;
+				}
+				out_tab[out_cnt].name = argv[i] + 2;
+				if (!strlen(out_tab[out_cnt].name)) {
 					printf("ERROR: No Outfile Name\n");
 					return -15;
 				}
+				out_tab[out_cnt].low_addr = lowest_output_addr;
+				out_tab[out_cnt].hdrtype = hdrtype;
+				out_tab[out_cnt].par1 = par1;
+				out_cnt++;
+				opt_changed = 0;
 				break;
 			default:
 				printf("ERROR: Unknown Option '%s'\n", argv[i]);
@@ -314,52 +1997,61 @@ int main(int argc, char** argv) {
 			}
 		}else {
 			infilename = argv[i];
+			file_bytes = bin_bytes_cnt;
+			file_ovw = warnings_cnt;
 			res = read_infile(infilename);
 			if (res) {
 				break;
 			}else {
 				printf("Input File '%s' OK, %d lines\n", infilename, in_line_cnt);
+				if (stats) printf("(%d Bytes, %d Bytes overwritten)\n", bin_bytes_cnt - file_bytes, warnings_cnt - file_ovw);
 			}
 		}
 	}
 
+	if (lint) {
+		free(ext_tab);
+		if (res) return res;
+		if (!bin_bytes_cnt) {
+			printf("ERROR: No or empty Input Files\n");
+			return -12;
+		}
+		printf("Lint OK: %d Files, %d Lines, %d Bytes in %d Extents, %d Warnings (%.3f msec)\n",
+			lint_file_cnt, total_line_cnt, bin_bytes_cnt, ext_cnt, lint_nonmono_cnt, (get_secs() - t0) * 1000.0);
+		return 0;
+	}
 	if (warnings_cnt) {
 		printf("*** %d Warnings found ***\n", warnings_cnt);
 	}
+	if (uicr_bytes_cnt) {
+		printf("Info: %d Bytes for UICR (only written with '--split')\n", uicr_bytes_cnt);
+	}
 	if (!res) {
 		if (bin_bytes_cnt == 0) {
 			printf("ERROR: No or empty Input Files\n");
 			res = -12;
 		}else {
 			printf("OK. Input %d Bytes (Addr: 0x%X...0x%X) Total: %d lines\n", bin_bytes_cnt, min_bin_addr, max_bin_addr, total_line_cnt);
-			/*
-			for (anz = 0, i = min_bin_addr; i <= max_bin_addr; i++) if (!usedbuf[i]) anz++;	printf("(Check: %d unused Bytes)\n", anz);
-			for (anz = 0, i = min_bin_addr; i <= max_bin_addr; i++) if (usedbuf[i]==1) anz++;	printf("(Check: %d 1-time used Bytes)\n", anz);
-			*/
-			if (outfilename) {
-				if (lowest_output_addr >= 0) min_bin_addr = lowest_output_addr;
-				anz = max_bin_addr - min_bin_addr+1;	// min_bin_addr is last written addr
-				if (anz <= 0) {
-					printf("ERROR: No Data to Write\n");
-					return -16;
-				}
-				printf("Write '%s', %d Bytes (Addr: 0x%X...0x%X)\n", outfilename, anz, min_bin_addr, max_bin_addr);
-				outf = fopen(outfilename, "wb");
-				if (!outf) {
-					printf("ERROR: Can't open '%s'\n", outfilename);
-					return -17;
-				}
-				if (hdrtype >= 0) {
-					res = write_header(outf, hdrtype, min_bin_addr, anz, par1);
-					if (res) return res;
-				}
-
-				if (fwrite(&binbuf[min_bin_addr], 1, anz, outf) != anz) {
-					printf("ERROR: Write Error '%s'\n", outfilename);
-					res = -18;
-				}
-				fclose(outf);
+			if (usage) {
+				res = usage_report(usage_json);
+				if (res) return res;
+			}
+			if (opt_changed && out_cnt) {	// Compatible: Options after (single) '-o'
+				out_tab[out_cnt - 1].low_addr = lowest_output_addr;
+				out_tab[out_cnt - 1].hdrtype = hdrtype;
+				out_tab[out_cnt - 1].par1 = par1;
+			}
+			for (anz = 0; anz < out_cnt && !res; anz++) {
+				res = write_output(&out_tab[anz]);
+			}
+			if (!res && split_prefix) res = write_split(split_prefix, hdrtype);
+			for (anz = 0; anz < out_cnt && !res && store_dir; anz++) {
+				res = store_file(store_dir, out_tab[anz].name);
+			}
+			for (anz = 0; anz < out_cnt && !res && pkt_mtu; anz++) {
+				res = write_packets(out_tab[anz].name, pkt_mtu);
 			}
+			if (stats) print_stats();
 
 		}
 	}